@@ -12,6 +12,11 @@
 #include <chrono>
 #include <cstring>
 #include <iostream>
+#include <cerrno>
+#include <cstdint>
+#include <limits>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 namespace {
     template<typename T, typename... Args>
@@ -87,6 +92,9 @@ public:
 
     ~queue() {
         while(tryPop());
+        int const fd = m_eventFd.load(std::memory_order_acquire);
+        if(fd != -1)
+            ::close(fd);
     }
 
     bool tryPush(const T& newItem) {
@@ -103,6 +111,7 @@ public:
         }
 
         m_dataAwaiting.notify_one();
+        signalEvent();
         return true;
     }
 
@@ -122,6 +131,7 @@ public:
         }
 
         m_dataAwaiting.notify_one();
+        signalEvent();
     }
 
     bool tryPop(T& item) {
@@ -170,6 +180,51 @@ public:
         }
     }
 
+    /*
+     * Makes the queue signal an eventfd when data arrives, so the consumer
+     * can sit in poll/epoll instead of waitPop. Signals are coalesced: after
+     * one signal no more are sent until the consumer calls acknowledgeEvent().
+     * Returns the descriptor or -1 if it cannot be created.
+    */
+    int enableEventNotification() {
+        int fd = m_eventFd.load(std::memory_order_acquire);
+        if(fd != -1)
+            return fd;
+
+        int const newFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if(newFd == -1)
+            return -1;
+
+        if(!m_eventFd.compare_exchange_strong(fd, newFd, std::memory_order_acq_rel)) {
+            ::close(newFd);
+            return fd;
+        }
+
+        // items pushed before the descriptor existed were not signalled
+        if(!empty())
+            signalEvent();
+        return newFd;
+    }
+
+    int eventFd() const {
+        return m_eventFd.load(std::memory_order_acquire);
+    }
+
+    /*
+     * Resets the eventfd and rearms the signal. Must be called before
+     * draining the queue with tryPop, otherwise items pushed during
+     * the drain may go unnoticed.
+    */
+    void acknowledgeEvent() {
+        int const fd = m_eventFd.load(std::memory_order_acquire);
+        if(fd == -1)
+            return;
+
+        eventfd_t counter;
+        while(::eventfd_read(fd, &counter) == -1 && errno == EINTR);
+        m_eventPending.store(false, std::memory_order_release);
+    }
+
     std::string storeToDisk(const char* name) {
 
         std::string filename(name);
@@ -302,10 +357,25 @@ private:
         newTail->number = ++m_tail->number;
         m_tail = newTail;        
     }
+
+    void signalEvent()
+    {
+        int const fd = m_eventFd.load(std::memory_order_acquire);
+        if(fd == -1)
+            return;
+
+        if(m_eventPending.load(std::memory_order_acquire) ||
+                m_eventPending.exchange(true, std::memory_order_acq_rel))
+            return;
+
+        while(::eventfd_write(fd, 1) == -1 && errno == EINTR);
+    }
     /*****PUSH AREA END*****/
 private:
     std::atomic_bool        m_stopWaitForData{false};
     std::atomic_bool        m_stopWaitForRoom{false};
+    std::atomic_bool        m_eventPending{false};
+    std::atomic_int         m_eventFd{-1};
     std::mutex              m_headMutex;
     std::unique_ptr<node>   m_head;
     std::mutex              m_tailMutex;
@@ -313,4 +383,229 @@ private:
     std::condition_variable m_dataAwaiting;
     std::condition_variable m_roomAwaiting;
 };
+
+/*
+ * Queue of variable-length byte records stored in a fixed ring buffer.
+ * Producer reserves room, writes the record in place and commits it;
+ * consumer peeks the record in place and releases it. Records are
+ * length-prefixed and never split by the end of the buffer.
+ * Supports one producer and one consumer at a time.
+*/
+template <std::size_t CAPACITY = 65536>
+class byteQueue{
+private:
+    using header = std::uint32_t;
+    static constexpr header WRAP_MARKER = std::numeric_limits<header>::max();
+
+    static_assert(CAPACITY % sizeof(header) == 0, "CAPACITY must be a multiple of record header size");
+    static_assert(CAPACITY >= 2 * sizeof(header), "CAPACITY is too small");
+    static_assert(CAPACITY < WRAP_MARKER, "CAPACITY is too big");
+
+    static constexpr std::size_t MAX_RECORD_SIZE = CAPACITY - sizeof(header);
+
+public:
+    struct span
+    {
+        char* data {nullptr};
+        std::size_t size = 0;
+    };
+
+    byteQueue() = default;
+
+    byteQueue(const byteQueue& other) = delete;
+    byteQueue& operator= (const byteQueue& other) = delete;
+
+    char* tryReserve(std::size_t size) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return reserve(size)? m_buffer + m_reservedPos + sizeof(header): nullptr;
+    }
+
+    char* waitReserve(std::size_t size) {
+        if(size > MAX_RECORD_SIZE)
+            return nullptr;
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if(m_reserved)
+            return nullptr;
+
+        m_producerWaiting = true;
+        m_roomAwaiting.wait(lock, [&](){ return reserve(size) ||
+                    m_stopWaitForRoom.load(std::memory_order_acquire); });
+        m_producerWaiting = false;
+
+        if(m_stopWaitForRoom.exchange(false, std::memory_order_acq_rel)) {
+            m_reserved = false;
+            return nullptr;
+        }
+
+        return m_buffer + m_reservedPos + sizeof(header);
+    }
+
+    bool commit() {
+        return commit(m_reservedSize);
+    }
+
+    /*
+     * size may be smaller than the reserved one, the rest is given back.
+     * Returns false and drops the reservation if size is bigger than
+     * the reserved one or nothing is reserved.
+    */
+    bool commit(std::size_t size) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if(!m_reserved || size > m_reservedSize) {
+                m_reserved = false;
+                return false;
+            }
+
+            if(m_reservedPos != m_write) {
+                writeHeader(m_write, WRAP_MARKER);
+                m_used += CAPACITY - m_write;
+            }
+
+            writeHeader(m_reservedPos, static_cast<header>(size));
+            m_used += recordSize(size);
+            m_write = (m_reservedPos + recordSize(size)) % CAPACITY;
+            m_reserved = false;
+        }
+
+        m_dataAwaiting.notify_one();
+        return true;
+    }
+
+    span tryPeek() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return peek();
+    }
+
+    span waitPeek() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_consumerWaiting = true;
+        m_dataAwaiting.wait(lock, [&](){ return m_used != 0 ||
+                    m_stopWaitForData.load(std::memory_order_acquire); });
+        m_consumerWaiting = false;
+
+        if(m_stopWaitForData.exchange(false, std::memory_order_acq_rel))
+            return span();
+
+        return peek();
+    }
+
+    void release() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if(m_used == 0)
+                return;
+
+            skipWrapMarker();
+            std::size_t const size = recordSize(readHeader(m_read));
+            m_used -= size;
+            m_read = (m_read + size) % CAPACITY;
+        }
+
+        m_roomAwaiting.notify_one();
+    }
+
+    bool empty() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_used == 0;
+    }
+
+    void stopWaiting(){
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(m_consumerWaiting) {
+            m_stopWaitForData.store(true, std::memory_order_release);
+            m_dataAwaiting.notify_all();
+        } else if(m_producerWaiting) {
+            m_stopWaitForRoom.store(true, std::memory_order_release);
+            m_roomAwaiting.notify_all();
+        }
+    }
+
+private:
+    static std::size_t recordSize(std::size_t size)
+    {
+        return (sizeof(header) + size + sizeof(header) - 1) / sizeof(header) * sizeof(header);
+    }
+
+    header readHeader(std::size_t pos) const
+    {
+        header value;
+        std::memcpy(&value, m_buffer + pos, sizeof(header));
+        return value;
+    }
+
+    void writeHeader(std::size_t pos, header value)
+    {
+        std::memcpy(m_buffer + pos, &value, sizeof(header));
+    }
+
+    /*****PUSH AREA*****/
+    bool reserve(std::size_t size)
+    {
+        if(m_reserved || size > MAX_RECORD_SIZE)
+            return false;
+
+        std::size_t const needed = recordSize(size);
+
+        if(m_used == 0)
+            m_read = m_write = 0;
+
+        if(m_used == 0 || m_write > m_read) {
+            if(needed <= CAPACITY - m_write)
+                m_reservedPos = m_write;
+            else if(needed <= m_read)
+                m_reservedPos = 0;
+            else
+                return false;
+        } else if(needed <= m_read - m_write) {
+            m_reservedPos = m_write;
+        } else {
+            return false;
+        }
+
+        m_reservedSize = size;
+        m_reserved = true;
+        return true;
+    }
+    /*****PUSH AREA END*****/
+
+    /*****POP AREA*****/
+    void skipWrapMarker()
+    {
+        if(readHeader(m_read) != WRAP_MARKER)
+            return;
+
+        m_used -= CAPACITY - m_read;
+        m_read = 0;
+    }
+
+    span peek()
+    {
+        if(m_used == 0)
+            return span();
+
+        skipWrapMarker();
+        span record;
+        record.data = m_buffer + m_read + sizeof(header);
+        record.size = readHeader(m_read);
+        return record;
+    }
+    /*****POP AREA END*****/
+private:
+    std::atomic_bool        m_stopWaitForData{false};
+    std::atomic_bool        m_stopWaitForRoom{false};
+    std::mutex              m_mutex;
+    std::size_t             m_read = 0;
+    std::size_t             m_write = 0;
+    std::size_t             m_used = 0;
+    std::size_t             m_reservedPos = 0;
+    std::size_t             m_reservedSize = 0;
+    bool                    m_reserved = false;
+    bool                    m_producerWaiting = false;
+    bool                    m_consumerWaiting = false;
+    std::condition_variable m_dataAwaiting;
+    std::condition_variable m_roomAwaiting;
+    alignas(header) char    m_buffer[CAPACITY];
+};
 } // namespace threadsafe
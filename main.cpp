@@ -4,6 +4,8 @@
 #include <chrono>
 #include <random>
 #include <iterator>
+#include <poll.h>
+#include <sys/eventfd.h>
 
 constexpr int QUEUE_SIZE = 10;
 constexpr int NUMBER_OF_ELEMENTS = 50;
@@ -238,6 +240,235 @@ BOOST_AUTO_TEST_CASE(two_threads_are_writers_other_one_is_reader)
     reader.join();
 }
 
+BOOST_AUTO_TEST_CASE(one_writer_one_reader_tryPush_event_loop_tryPop)
+{
+    threadsafe::queue<int, QUEUE_SIZE> queue;
+    int fd = queue.enableEventNotification();
+    BOOST_REQUIRE_MESSAGE(fd != -1, "eventfd wasn't created");
+    BOOST_CHECK_MESSAGE(queue.eventFd() == fd, "queue returns wrong descriptor");
+
+    std::thread writer([&]() {
+                    for (int j = 0; j < NUMBER_OF_ELEMENTS; ++j) {
+                        unpredictableDelay();
+                        while(!queue.tryPush(j))
+                            unpredictableDelay();
+                    }
+              });
+
+    std::thread reader([&]() {
+        int element;
+        int counter = 0;
+        pollfd event{fd, POLLIN, 0};
+
+        while (counter < NUMBER_OF_ELEMENTS) {
+            bool signalled = (::poll(&event, 1, 1000) == 1);
+            BOOST_CHECK_MESSAGE(signalled, "event wasn't signalled");
+            if(!signalled)
+                break;
+            queue.acknowledgeEvent();
+
+            while (queue.tryPop(element)) {
+                BOOST_CHECK_MESSAGE(element == counter, "Expected value " << counter << "; real value " << element);
+                ++counter;
+            }
+        }
+        BOOST_CHECK_MESSAGE(!queue.tryPop(element), "Expected that queue is empty");
+    });
+
+    writer.join();
+    reader.join();
+}
+
+BOOST_AUTO_TEST_CASE(event_notification_is_coalesced_until_acknowledged)
+{
+    threadsafe::queue<int, QUEUE_SIZE> queue;
+    int fd = queue.enableEventNotification();
+    BOOST_REQUIRE_MESSAGE(fd != -1, "eventfd wasn't created");
+    BOOST_CHECK_MESSAGE(queue.enableEventNotification() == fd, "descriptor was recreated");
+
+    for (int j = 0; j < QUEUE_SIZE; ++j)
+        BOOST_CHECK_MESSAGE(queue.tryPush(j), "value wasn't pushed");
+
+    eventfd_t counter = 0;
+    BOOST_CHECK_MESSAGE(::eventfd_read(fd, &counter) == 0, "event wasn't signalled");
+    BOOST_CHECK_MESSAGE(counter == 1, "Expected one signal per burst; real signals " << counter);
+
+    pollfd event{fd, POLLIN, 0};
+    queue.acknowledgeEvent();
+    BOOST_CHECK_MESSAGE(::poll(&event, 1, 0) == 0, "Expected that no event is pending");
+
+    BOOST_CHECK_MESSAGE(queue.tryPop(), "value wasn't popped");
+    BOOST_CHECK_MESSAGE(::poll(&event, 1, 0) == 0, "Expected that no event is pending");
+
+    BOOST_CHECK_MESSAGE(queue.tryPush(QUEUE_SIZE), "value wasn't pushed");
+    BOOST_CHECK_MESSAGE(::poll(&event, 1, 0) == 1, "Expected that push signals event again");
+}
+
+BOOST_AUTO_TEST_CASE(event_notification_enabled_on_filled_queue_is_signalled)
+{
+    threadsafe::queue<int, QUEUE_SIZE> queue;
+
+    BOOST_CHECK_MESSAGE(queue.tryPush(0), "value wasn't pushed");
+    BOOST_CHECK_MESSAGE(queue.tryPush(1), "value wasn't pushed");
+
+    int fd = queue.enableEventNotification();
+    BOOST_REQUIRE_MESSAGE(fd != -1, "eventfd wasn't created");
+
+    pollfd event{fd, POLLIN, 0};
+    BOOST_CHECK_MESSAGE(::poll(&event, 1, 100) == 1, "Expected that queued items are signalled");
+}
+
+BOOST_AUTO_TEST_CASE(one_writer_one_reader_byteQueue_reserve_commit_peek_release)
+{
+    constexpr std::size_t BYTE_QUEUE_SIZE = 64;
+    threadsafe::byteQueue<BYTE_QUEUE_SIZE> queue;
+
+    BOOST_CHECK_MESSAGE(queue.tryReserve(BYTE_QUEUE_SIZE) == nullptr, "record bigger than queue was reserved");
+    BOOST_CHECK_MESSAGE(queue.tryPeek().data == nullptr, "Expected that queue has no record to be peeked");
+
+    std::thread writer([&]() {
+                    for (int j = 0; j < NUMBER_OF_ELEMENTS; ++j) {
+                        std::size_t size = static_cast<std::size_t>(j % 13) + 1;
+                        char* record = queue.waitReserve(size + 4);
+                        BOOST_CHECK_MESSAGE(record != nullptr, "room wasn't reserved");
+                        if(!record)
+                            break;
+                        std::memset(record, j, size);
+                        BOOST_CHECK_MESSAGE(queue.commit(size), "record wasn't committed");
+                    }
+              });
+
+    std::thread reader([&]() {
+        for (int j = 0; j < NUMBER_OF_ELEMENTS; ++j) {
+            unpredictableDelay();
+            auto record = queue.waitPeek();
+            std::size_t size = static_cast<std::size_t>(j % 13) + 1;
+            BOOST_CHECK_MESSAGE(record.size == size, "Expected size " << size << "; real size " << record.size);
+            for (std::size_t i = 0; i < record.size; ++i)
+                BOOST_CHECK_MESSAGE(record.data[i] == static_cast<char>(j), "record " << j << " is corrupted");
+            queue.release();
+        }
+        BOOST_CHECK_MESSAGE(queue.empty(), "Expected that queue is empty");
+    });
+
+    writer.join();
+    reader.join();
+}
+
+BOOST_AUTO_TEST_CASE(byteQueue_record_wraps_to_the_start_of_the_ring)
+{
+    // header is 4 bytes, records are rounded up to 4 bytes
+    threadsafe::byteQueue<64> queue;
+
+    BOOST_CHECK_MESSAGE(queue.tryReserve(SIZE_MAX) == nullptr, "overflowing record was reserved");
+    BOOST_CHECK_MESSAGE(queue.waitReserve(SIZE_MAX) == nullptr, "overflowing record was reserved");
+    BOOST_CHECK_MESSAGE(queue.tryReserve(61) == nullptr, "record bigger than queue was reserved");
+
+    char* first = queue.tryReserve(28);
+    BOOST_REQUIRE_MESSAGE(first != nullptr, "room wasn't reserved");
+    std::memset(first, 1, 28);
+    BOOST_CHECK_MESSAGE(queue.commit(), "record wasn't committed");
+
+    char* second = queue.tryReserve(20);
+    BOOST_REQUIRE_MESSAGE(second != nullptr, "room wasn't reserved");
+    std::memset(second, 2, 20);
+    BOOST_CHECK_MESSAGE(queue.commit(), "record wasn't committed");
+
+    // 8 bytes left at the end, 32 free at the start
+    BOOST_CHECK_MESSAGE(queue.tryPeek().data == first, "first record wasn't peeked");
+    queue.release();
+
+    char* wrapped = queue.tryReserve(12);
+    BOOST_REQUIRE_MESSAGE(wrapped == first, "record wasn't placed at the start of the ring");
+    std::memset(wrapped, 3, 12);
+    BOOST_CHECK_MESSAGE(queue.commit(), "record wasn't committed");
+
+    char* last = queue.tryReserve(12);
+    BOOST_REQUIRE_MESSAGE(last != nullptr, "room wasn't reserved");
+    std::memset(last, 4, 12);
+    BOOST_CHECK_MESSAGE(queue.commit(), "record wasn't committed");
+
+    BOOST_CHECK_MESSAGE(queue.tryReserve(0) == nullptr, "Expected that queue is full");
+
+    const char expected[] = {2, 3, 4};
+    const std::size_t sizes[] = {20, 12, 12};
+    for (int j = 0; j < 3; ++j) {
+        auto record = queue.tryPeek();
+        BOOST_CHECK_MESSAGE(record.data != nullptr, "record wasn't peeked");
+        BOOST_CHECK_MESSAGE(record.size == sizes[j], "Expected size " << sizes[j] << "; real size " << record.size);
+        for (std::size_t i = 0; record.data && i < record.size; ++i)
+            BOOST_CHECK_MESSAGE(record.data[i] == expected[j], "record " << j << " is corrupted");
+        queue.release();
+    }
+
+    BOOST_CHECK_MESSAGE(queue.empty(), "Expected that queue is empty");
+    BOOST_CHECK_MESSAGE(queue.tryPeek().data == nullptr, "Expected that queue has no record to be peeked");
+}
+
+BOOST_AUTO_TEST_CASE(byteQueue_commit_reports_dropped_record)
+{
+    threadsafe::byteQueue<64> queue;
+
+    BOOST_CHECK_MESSAGE(!queue.commit(), "nothing was reserved but commit succeeded");
+
+    BOOST_REQUIRE_MESSAGE(queue.tryReserve(4) != nullptr, "room wasn't reserved");
+    BOOST_CHECK_MESSAGE(queue.waitReserve(4) == nullptr, "second reservation was made before commit");
+    BOOST_CHECK_MESSAGE(!queue.commit(8), "record bigger than reservation was committed");
+    BOOST_CHECK_MESSAGE(queue.empty(), "dropped record is in queue");
+
+    BOOST_REQUIRE_MESSAGE(queue.tryReserve(4) != nullptr, "reservation wasn't dropped");
+    BOOST_CHECK_MESSAGE(queue.commit(2), "record wasn't committed");
+    BOOST_CHECK_MESSAGE(queue.tryPeek().size == 2, "record has wrong size");
+}
+
+BOOST_AUTO_TEST_CASE(byteQueue_stopWaiting_unblocks_waitPeek_and_waitReserve)
+{
+    threadsafe::byteQueue<64> queue;
+    std::atomic_bool done{false};
+
+    std::thread reader([&]() {
+        BOOST_CHECK_MESSAGE(queue.waitPeek().data == nullptr, "Expected that waiting was stopped");
+        done.store(true);
+    });
+
+    while (!done.load()) {
+        unpredictableDelay();
+        queue.stopWaiting();
+    }
+    reader.join();
+
+    // nobody waits for data, so the next waitPeek must not be stopped
+    queue.stopWaiting();
+    BOOST_REQUIRE_MESSAGE(queue.tryReserve(4) != nullptr, "room wasn't reserved");
+    BOOST_CHECK_MESSAGE(queue.commit(), "record wasn't committed");
+    auto record = queue.waitPeek();
+    BOOST_CHECK_MESSAGE(record.data != nullptr, "record wasn't peeked");
+    BOOST_CHECK_MESSAGE(record.size == 4, "Expected size 4; real size " << record.size);
+    queue.release();
+
+    // nobody waits for room, so the next waitReserve must not be stopped
+    BOOST_REQUIRE_MESSAGE(queue.tryReserve(4) != nullptr, "room wasn't reserved");
+    BOOST_CHECK_MESSAGE(queue.commit(), "record wasn't committed");
+    queue.stopWaiting();
+    BOOST_REQUIRE_MESSAGE(queue.waitReserve(4) != nullptr, "room wasn't reserved");
+    BOOST_CHECK_MESSAGE(queue.commit(), "record wasn't committed");
+
+    BOOST_REQUIRE_MESSAGE(queue.tryReserve(40) != nullptr, "room wasn't reserved");
+    BOOST_CHECK_MESSAGE(queue.commit(), "record wasn't committed");
+
+    done.store(false);
+    std::thread writer([&]() {
+        BOOST_CHECK_MESSAGE(queue.waitReserve(4) == nullptr, "Expected that waiting was stopped");
+        done.store(true);
+    });
+
+    while (!done.load()) {
+        unpredictableDelay();
+        queue.stopWaiting();
+    }
+    writer.join();
+}
+
 BOOST_AUTO_TEST_CASE(store_and_try_read_from_disk_fundamental_int_type)
 {
     threadsafe::queue<int, QUEUE_SIZE> queueForStore;